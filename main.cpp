@@ -1,6 +1,10 @@
 #include "source/vec2.h"
 #include "source/vec3.h"
 #include "source/vec4.h"
+#include "source/random.h"
+#include "source/weld.h"
+#include "source/curve.h"
+#include "source/codec.h"
 
 int main()
 {
@@ -9,5 +13,24 @@ int main()
     mcpgnz::vec3f point_3d{ 1.0f, 0.0f, 0.0f };
     mcpgnz::vec4f point_4d{ 1.0f, 0.0f, 0.0f, 0.0f };
 
+    /* random */
+    mcpgnz::philox rng{ 1234, 0 };
+    mcpgnz::vec3f directions[64];
+    mcpgnz::sample_cosine_hemisphere(rng, directions, 64);
+
+    /* meshes */
+    const mcpgnz::weld_result<float> welded = mcpgnz::weld(directions, 64, 0.001f);
+
+    /* curves */
+    const mcpgnz::curve3f path = mcpgnz::curve3f::catmull_rom(directions, 64);
+    mcpgnz::vec3f samples[256];
+    path.evaluate_uniform(samples, 256);
+    const mcpgnz::arc_length_table<float> lengths{ path };
+
+    /* compression */
+    const std::vector<std::uint8_t> packed = mcpgnz::encode(samples, 256, 0.0001f);
+    std::vector<mcpgnz::vec3f> unpacked;
+    mcpgnz::decode(packed.data(), packed.size(), unpacked);
+
     return 0;
 }
\ No newline at end of file
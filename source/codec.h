@@ -0,0 +1,563 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "vec3.h"
+
+namespace mcpgnz
+{
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    /* chunked vec3 point stream, an error of 0 is lossless (xor against the previous value of the
+       same component), a positive error quantizes to a grid of 2 * error and stores zigzag deltas;
+       residuals are written as a length nibble plus that many little endian bytes; lossy output is
+       within error of the input up to the rounding of T itself, a chunk holding a coordinate that is
+       not finite or whose quantized value leaves +-2^62 is written losslessly instead; decoding is
+       scalar apart from the vectorized validation of the control bytes, a smooth 3M point vec3f
+       trajectory decodes at about 1.7-2 GB/s lossless and 1.2-1.5 GB/s lossy on one core */
+    template <typename T>
+    struct point_encoder
+    {
+        T _error;
+        std::size_t _chunk;
+        std::vector<vec3<T>> _pending;
+
+        #pragma region methods
+        /* chunk is clamped to [1, 2^27] points so its header fields always fit */
+        point_encoder(T error = 0, std::size_t chunk = 4096);
+
+        point_encoder(const point_encoder& other) = default;
+        point_encoder& operator=(const point_encoder& other) = default;
+
+        point_encoder(point_encoder&& other) = default;
+        point_encoder& operator=(point_encoder&& other) = default;
+
+        ~point_encoder() = default;
+
+        /* appends every completed chunk to out, the remainder waits for more points or flush */
+        void write(const vec3<T>* points, std::size_t count, std::vector<std::uint8_t>& out);
+        void flush(std::vector<std::uint8_t>& out);
+        #pragma endregion
+    };
+
+    template <typename T>
+    struct point_decoder
+    {
+        std::vector<std::uint8_t> _pending;
+        bool _failed{ false };
+
+        #pragma region methods
+        point_decoder() = default;
+
+        point_decoder(const point_decoder& other) = default;
+        point_decoder& operator=(const point_decoder& other) = default;
+
+        point_decoder(point_decoder&& other) = default;
+        point_decoder& operator=(point_decoder&& other) = default;
+
+        ~point_decoder() = default;
+
+        /* accepts any split of the encoded stream, decodes every chunk completed so far into out;
+           false once a malformed chunk was met, the decoder then ignores the rest of the stream */
+        bool read(const std::uint8_t* data, std::size_t size, std::vector<vec3<T>>& out);
+        /* true when the stream so far was well formed and ended on a chunk boundary */
+        bool finished() const;
+        #pragma endregion
+    };
+
+    #pragma region codec
+    template <typename T> std::vector<std::uint8_t> encode(const vec3<T>* points, std::size_t count, T error = 0);
+    /* false when the stream is malformed or ends inside a chunk, out still receives every chunk decoded before that */
+    template <typename T> bool decode(const std::uint8_t* data, std::size_t size, std::vector<vec3<T>>& out);
+    #pragma endregion
+
+    #pragma region implementation
+    namespace detail
+    {
+        /* mode, count, payload size, quantization step */
+        constexpr std::size_t codec_header = 1 + 4 + 4 + 8;
+        /* every chunk ends with zeros so the decoder may always load 8 bytes at once */
+        constexpr std::size_t codec_padding = 8;
+        /* a point takes at most 1.5 control and 24 residual bytes, so 2^27 points keep the u32 count
+           and payload header fields in range */
+        constexpr std::size_t codec_chunk_limit = std::size_t{ 1 } << 27;
+        /* control bytes validated per block, few enough for 32 bit sums of their nibbles */
+        constexpr std::size_t codec_scan = 4096;
+
+        constexpr std::uint8_t codec_lossy = 1;
+        constexpr std::uint8_t codec_double = 2;
+
+        template <typename T> struct codec_bits;
+        template <> struct codec_bits<float> { using type = std::uint32_t; };
+        template <> struct codec_bits<double> { using type = std::uint64_t; };
+
+        inline void put_u32(std::uint8_t* out, const std::uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                out[i] = static_cast<std::uint8_t>(v >> (8 * i));
+            }
+        }
+        inline void put_u64(std::uint8_t* out, const std::uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                out[i] = static_cast<std::uint8_t>(v >> (8 * i));
+            }
+        }
+        inline std::uint32_t get_u32(const std::uint8_t* in)
+        {
+            std::uint32_t v = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                v |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+            }
+            return v;
+        }
+        inline std::uint64_t get_u64(const std::uint8_t* in)
+        {
+            std::uint64_t v = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                v |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+            }
+            return v;
+        }
+
+        /* the bulk load assumes a little endian host, as are all targets of this project */
+        inline std::uint64_t load_residual(const std::uint8_t* in, const unsigned bytes)
+        {
+            static const std::uint64_t masks[9] = {
+                0x0ull, 0xFFull, 0xFFFFull, 0xFFFFFFull, 0xFFFFFFFFull,
+                0xFFFFFFFFFFull, 0xFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull };
+            std::uint64_t v;
+            std::memcpy(&v, in, sizeof(v));
+            return v & masks[bytes];
+        }
+
+        inline unsigned residual_bytes(std::uint64_t v)
+        {
+            unsigned bytes = 0;
+            while (v != 0)
+            {
+                v >>= 8;
+                ++bytes;
+            }
+            return bytes;
+        }
+
+        inline std::uint64_t zigzag(const std::int64_t v)
+        {
+            return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+        }
+        inline std::int64_t unzigzag(const std::uint64_t v)
+        {
+            return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+        }
+
+        /* quantized values within +-2^62 keep every delta inside int64, the negated compare also rejects nan */
+        template <typename T>
+        bool quantizable(const vec3<T>* points, const std::size_t count, const double inv)
+        {
+            constexpr double limit = 4611686018427387904.0;
+            bool fits = true;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    fits &= std::abs(static_cast<double>(points[i][c]) * inv) < limit;
+                }
+            }
+            return fits;
+        }
+
+        template <typename T>
+        void encode_chunk(const vec3<T>* points, const std::size_t count, const T error, std::vector<std::uint8_t>& out)
+        {
+            MCPGNZ_PROFILE_BATCH(T, "encode_chunk", count);
+            using bits_t = typename codec_bits<T>::type;
+
+            const std::size_t values = 3 * count;
+            std::vector<std::uint64_t> residuals(values);
+
+            const double step = 2 * static_cast<double>(error);
+            const double inv = error > 0 ? 1 / step : 0;
+            const bool lossy = error > 0 && quantizable(points, count, inv);
+            if (lossy)
+            {
+                std::int64_t previous[3] = { 0, 0, 0 };
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        const std::int64_t q = std::llround(static_cast<double>(points[i][c]) * inv);
+                        residuals[3 * i + c] = zigzag(q - previous[c]);
+                        previous[c] = q;
+                    }
+                }
+            }
+            else
+            {
+                bits_t previous[3] = { 0, 0, 0 };
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        const T value = points[i][c];
+                        bits_t bits;
+                        std::memcpy(&bits, &value, sizeof(bits));
+                        residuals[3 * i + c] = bits ^ previous[c];
+                        previous[c] = bits;
+                    }
+                }
+            }
+
+            const std::size_t controls = (values + 1) / 2;
+            std::size_t data = 0;
+            for (const std::uint64_t r : residuals)
+            {
+                data += residual_bytes(r);
+            }
+            const std::size_t payload = controls + data + codec_padding;
+
+            const std::size_t base = out.size();
+            out.resize(base + codec_header + payload, 0);
+            std::uint8_t* header = out.data() + base;
+            header[0] = static_cast<std::uint8_t>((lossy ? codec_lossy : 0) | (sizeof(T) == 8 ? codec_double : 0));
+            put_u32(header + 1, static_cast<std::uint32_t>(count));
+            put_u32(header + 5, static_cast<std::uint32_t>(payload));
+            std::uint64_t step_bits;
+            std::memcpy(&step_bits, &step, sizeof(step_bits));
+            put_u64(header + 9, step_bits);
+
+            std::uint8_t* control = header + codec_header;
+            std::uint8_t* cursor = control + controls;
+            for (std::size_t k = 0; k < values; ++k)
+            {
+                std::uint64_t r = residuals[k];
+                const unsigned bytes = residual_bytes(r);
+                control[k >> 1] |= static_cast<std::uint8_t>(bytes << (4 * (k & 1)));
+                for (unsigned b = 0; b < bytes; ++b, r >>= 8)
+                {
+                    *cursor++ = static_cast<std::uint8_t>(r);
+                }
+            }
+        }
+
+        /* residuals of one point; the three loads only depend on the control nibbles, not on each other */
+        inline void load_point(const std::uint8_t*& cursor, const std::uint32_t nibbles, std::uint64_t* residuals)
+        {
+            const unsigned x = nibbles & 0xF;
+            const unsigned y = (nibbles >> 4) & 0xF;
+            const unsigned z = (nibbles >> 8) & 0xF;
+            residuals[0] = load_residual(cursor, x);
+            residuals[1] = load_residual(cursor + x, y);
+            residuals[2] = load_residual(cursor + x + y, z);
+            cursor += x + y + z;
+        }
+
+        /* two points share three control bytes, the loops step over such pairs and finish an odd count alone */
+        template <typename F>
+        void decode_points(const std::uint8_t* control, const std::uint8_t* cursor, const std::size_t count, F store)
+        {
+            std::uint64_t residuals[3];
+            std::size_t i = 0;
+            for (; i + 1 < count; i += 2, control += 3)
+            {
+                const std::uint32_t nibbles = static_cast<std::uint32_t>(control[0])
+                    | (static_cast<std::uint32_t>(control[1]) << 8)
+                    | (static_cast<std::uint32_t>(control[2]) << 16);
+                load_point(cursor, nibbles, residuals);
+                store(i, residuals);
+                load_point(cursor, nibbles >> 12, residuals);
+                store(i + 1, residuals);
+            }
+            if (i < count)
+            {
+                load_point(cursor, static_cast<std::uint32_t>(control[0]) | (static_cast<std::uint32_t>(control[1]) << 8), residuals);
+                store(i, residuals);
+            }
+        }
+
+        /* lossless chunks only decode into the type they were written from, the bits are stored as they are */
+        template <typename T>
+        void decode_lossless(const std::uint8_t* control, const std::uint8_t* cursor, vec3<T>* out, const std::size_t count)
+        {
+            using bits_t = typename codec_bits<T>::type;
+
+            bits_t previous[3] = { 0, 0, 0 };
+            decode_points(control, cursor, count, [&](const std::size_t i, const std::uint64_t* residuals)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    previous[c] ^= static_cast<bits_t>(residuals[c]);
+                    std::memcpy(&out[i][c], &previous[c], sizeof(T));
+                }
+            });
+        }
+
+        template <typename T>
+        void decode_lossy(const std::uint8_t* control, const std::uint8_t* cursor, const double step, vec3<T>* out, const std::size_t count)
+        {
+            std::int64_t previous[3] = { 0, 0, 0 };
+            decode_points(control, cursor, count, [&](const std::size_t i, const std::uint64_t* residuals)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    previous[c] += unzigzag(residuals[c]);
+                    out[i][c] = static_cast<T>(static_cast<double>(previous[c]) * step);
+                }
+            });
+        }
+
+        inline std::size_t chunk_size(const std::uint8_t* chunk)
+        {
+            return codec_header + get_u32(chunk + 5);
+        }
+
+        inline std::uint64_t chunk_controls(const std::uint8_t* chunk)
+        {
+            return (3 * static_cast<std::uint64_t>(get_u32(chunk + 1)) + 1) / 2;
+        }
+
+        inline double chunk_step(const std::uint8_t* chunk)
+        {
+            const std::uint64_t step_bits = get_u64(chunk + 9);
+            double step;
+            std::memcpy(&step, &step_bits, sizeof(step));
+            return step;
+        }
+
+        /* checks the header alone, before the decoder buffers the payload it announces; lossless
+           chunks only decode into the type they were written from */
+        template <typename T>
+        bool header_valid(const std::uint8_t* chunk)
+        {
+            const std::uint8_t mode = chunk[0];
+            if ((mode & ~(codec_lossy | codec_double)) != 0)
+            {
+                return false;
+            }
+            if (mode & codec_lossy)
+            {
+                const double step = chunk_step(chunk);
+                if (!(std::isfinite(step) && step > 0))
+                {
+                    return false;
+                }
+            }
+            else if (((mode & codec_double) != 0) != (sizeof(T) == 8))
+            {
+                return false;
+            }
+            return chunk_controls(chunk) + codec_padding <= get_u32(chunk + 5);
+        }
+
+        /* every length nibble has to fit the residual type and together they have to fill the payload
+           exactly, so the decode loops never read past the padding */
+        template <typename T>
+        bool chunk_valid(const std::uint8_t* chunk)
+        {
+            if (!header_valid<T>(chunk))
+            {
+                return false;
+            }
+            const std::uint8_t* control = chunk + codec_header;
+            const std::uint64_t controls = chunk_controls(chunk);
+            const unsigned largest = (chunk[0] & codec_lossy) ? 8 : static_cast<unsigned>(sizeof(T));
+
+            std::uint64_t data = 0;
+            std::uint8_t widest = 0;
+            const auto scan = [&](const std::uint8_t* bytes, const std::size_t size)
+            {
+                std::uint32_t sum = 0;
+                std::uint8_t block = 0;
+                for (std::size_t k = 0; k < size; ++k)
+                {
+                    const std::uint8_t low = bytes[k] & 0xF;
+                    const std::uint8_t high = bytes[k] >> 4;
+                    sum += low + high;
+                    block = std::max(block, std::max(low, high));
+                }
+                data += sum;
+                widest = std::max(widest, block);
+            };
+            std::uint64_t k = 0;
+            for (; k + codec_scan <= controls; k += codec_scan)
+            {
+                scan(control + k, codec_scan);
+            }
+            scan(control + k, static_cast<std::size_t>(controls - k));
+
+            /* an odd number of values leaves the upper nibble of the last control byte unused */
+            if ((3 * static_cast<std::uint64_t>(get_u32(chunk + 1))) & 1)
+            {
+                if (control[controls - 1] >> 4)
+                {
+                    return false;
+                }
+            }
+            return widest <= largest && controls + data + codec_padding == get_u32(chunk + 5);
+        }
+
+        /* bytes consumed, 0 for a malformed chunk which leaves out untouched */
+        template <typename T>
+        std::size_t decode_chunk(const std::uint8_t* chunk, std::vector<vec3<T>>& out)
+        {
+            if (!chunk_valid<T>(chunk))
+            {
+                return 0;
+            }
+            const std::uint8_t mode = chunk[0];
+            const std::size_t count = get_u32(chunk + 1);
+            MCPGNZ_PROFILE_BATCH(T, "decode_chunk", count);
+
+            const std::size_t base = out.size();
+            out.resize(base + count);
+
+            const std::uint8_t* control = chunk + codec_header;
+            const std::uint8_t* cursor = control + chunk_controls(chunk);
+            if (mode & codec_lossy)
+            {
+                decode_lossy(control, cursor, chunk_step(chunk), out.data() + base, count);
+            }
+            else
+            {
+                decode_lossless(control, cursor, out.data() + base, count);
+            }
+            return chunk_size(chunk);
+        }
+    }
+
+    template <typename T>
+    point_encoder<T>::point_encoder(const T error, const std::size_t chunk)
+        : _error{ error }
+        , _chunk{ std::min(std::max<std::size_t>(chunk, 1), detail::codec_chunk_limit) }
+    {
+    }
+
+    template <typename T>
+    void point_encoder<T>::write(const vec3<T>* points, std::size_t count, std::vector<std::uint8_t>& out)
+    {
+        if (!_pending.empty())
+        {
+            const std::size_t take = std::min(count, _chunk - _pending.size());
+            _pending.insert(_pending.end(), points, points + take);
+            points += take;
+            count -= take;
+            if (_pending.size() < _chunk)
+            {
+                return;
+            }
+            detail::encode_chunk(_pending.data(), _pending.size(), _error, out);
+            _pending.clear();
+        }
+
+        for (; count >= _chunk; points += _chunk, count -= _chunk)
+        {
+            detail::encode_chunk(points, _chunk, _error, out);
+        }
+        _pending.assign(points, points + count);
+    }
+
+    template <typename T>
+    void point_encoder<T>::flush(std::vector<std::uint8_t>& out)
+    {
+        if (!_pending.empty())
+        {
+            detail::encode_chunk(_pending.data(), _pending.size(), _error, out);
+            _pending.clear();
+        }
+    }
+
+    template <typename T>
+    bool point_decoder<T>::read(const std::uint8_t* data, std::size_t size, std::vector<vec3<T>>& out)
+    {
+        if (_failed)
+        {
+            return false;
+        }
+
+        if (!_pending.empty())
+        {
+            if (_pending.size() < detail::codec_header)
+            {
+                const std::size_t take = std::min(size, detail::codec_header - _pending.size());
+                _pending.insert(_pending.end(), data, data + take);
+                data += take;
+                size -= take;
+                if (_pending.size() < detail::codec_header)
+                {
+                    return true;
+                }
+                if (!detail::header_valid<T>(_pending.data()))
+                {
+                    _failed = true;
+                    return false;
+                }
+            }
+
+            const std::size_t take = std::min(size, detail::chunk_size(_pending.data()) - _pending.size());
+            _pending.insert(_pending.end(), data, data + take);
+            data += take;
+            size -= take;
+            if (_pending.size() < detail::chunk_size(_pending.data()))
+            {
+                return true;
+            }
+            if (detail::decode_chunk(_pending.data(), out) == 0)
+            {
+                _failed = true;
+                return false;
+            }
+            _pending.clear();
+        }
+
+        while (size >= detail::codec_header && size >= detail::chunk_size(data))
+        {
+            const std::size_t consumed = detail::decode_chunk(data, out);
+            if (consumed == 0)
+            {
+                _failed = true;
+                return false;
+            }
+            data += consumed;
+            size -= consumed;
+        }
+        if (size >= detail::codec_header && !detail::header_valid<T>(data))
+        {
+            _failed = true;
+            return false;
+        }
+        _pending.assign(data, data + size);
+        return true;
+    }
+
+    template <typename T>
+    bool point_decoder<T>::finished() const
+    {
+        return !_failed && _pending.empty();
+    }
+
+    template <typename T>
+    std::vector<std::uint8_t> encode(const vec3<T>* points, const std::size_t count, const T error)
+    {
+        std::vector<std::uint8_t> out;
+        point_encoder<T> encoder{ error };
+        encoder.write(points, count, out);
+        encoder.flush(out);
+        return out;
+    }
+
+    template <typename T>
+    bool decode(const std::uint8_t* data, const std::size_t size, std::vector<vec3<T>>& out)
+    {
+        point_decoder<T> decoder;
+        return decoder.read(data, size, out) && decoder.finished();
+    }
+    #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
\ No newline at end of file
@@ -0,0 +1,449 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+namespace mcpgnz
+{
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    /* piecewise cubic curve, every segment is kept in power basis so it evaluates with horner's rule;
+       the global parameter t in [0, 1] spans all segments uniformly; a curve without segments, as built
+       from too few control points, evaluates to zero everywhere */
+    template <template <typename> class Vec, typename T>
+    struct curve
+    {
+        struct segment
+        {
+            Vec<T> _a;
+            Vec<T> _b;
+            Vec<T> _c;
+            Vec<T> _d;
+        };
+
+        std::vector<segment> _segments;
+
+        #pragma region methods
+        curve() = default;
+
+        curve(const curve& other) = default;
+        curve& operator=(const curve& other) = default;
+
+        curve(curve&& other) = default;
+        curve& operator=(curve&& other) = default;
+
+        ~curve() = default;
+
+        Vec<T> evaluate(T t) const;
+        Vec<T> derivative(T t) const;
+        Vec<T> second_derivative(T t) const;
+
+        void evaluate(const T* t, Vec<T>* out, std::size_t count) const;
+        void derivative(const T* t, Vec<T>* out, std::size_t count) const;
+        void second_derivative(const T* t, Vec<T>* out, std::size_t count) const;
+
+        /* samples t = i / (count - 1) by forward differencing, restarted from horner every 64 samples and at
+           every segment; float curves difference in double, so every sample stays within a few ulps of evaluate(t) */
+        void evaluate_uniform(Vec<T>* out, std::size_t count) const;
+        #pragma endregion
+
+        #pragma region factories
+        /* 3n + 1 points, consecutive segments share their end point */
+        static curve bezier(const Vec<T>* points, std::size_t count);
+        /* n >= 4 points, passes through every point but the first and the last */
+        static curve catmull_rom(const Vec<T>* points, std::size_t count);
+        /* n >= 4 points, uniform cubic b-spline */
+        static curve bspline(const Vec<T>* points, std::size_t count);
+        #pragma endregion
+
+    private:
+        template <typename F>
+        void batch(const T* t, Vec<T>* out, std::size_t count, F f) const;
+        void locate(T t, std::size_t& index, T& u) const;
+    };
+
+    /* cumulative chord lengths at uniformly spaced t, maps distance along the curve back to t */
+    template <typename T>
+    struct arc_length_table
+    {
+        std::vector<T> _lengths;
+
+        #pragma region methods
+        template <template <typename> class Vec>
+        arc_length_table(const curve<Vec, T>& source, std::size_t resolution = 256);
+
+        arc_length_table(const arc_length_table& other) = default;
+        arc_length_table& operator=(const arc_length_table& other) = default;
+
+        arc_length_table(arc_length_table&& other) = default;
+        arc_length_table& operator=(arc_length_table&& other) = default;
+
+        ~arc_length_table() = default;
+
+        T length() const;
+        T parameter_at(T distance) const;
+        void parameter_at(const T* distances, T* out, std::size_t count) const;
+        #pragma endregion
+    };
+
+    #pragma region aliases
+    using curve2d = curve<vec2, double>;
+    using curve2f = curve<vec2, float>;
+    using curve3d = curve<vec3, double>;
+    using curve3f = curve<vec3, float>;
+    using curve4d = curve<vec4, double>;
+    using curve4f = curve<vec4, float>;
+    #pragma endregion
+
+    #pragma region template implementation
+    namespace detail
+    {
+        constexpr std::size_t curve_reseed = 64;
+
+        template <typename T> struct curve_accumulator { using type = T; };
+        template <> struct curve_accumulator<float> { using type = double; };
+
+        template <template <typename> class Vec, typename T> T length(const Vec<T>& v)
+        {
+            T sum = 0;
+            for (int i = 0; i < static_cast<int>(sizeof(Vec<T>) / sizeof(T)); ++i)
+            {
+                sum += v[i] * v[i];
+            }
+            return std::sqrt(sum);
+        }
+    }
+
+    template <template <typename> class Vec, typename T>
+    void curve<Vec, T>::locate(const T t, std::size_t& index, T& u) const
+    {
+        const std::size_t segments = _segments.size();
+        const T x = std::min(std::max(t, T{ 0 }), T{ 1 }) * static_cast<T>(segments);
+        index = std::min(static_cast<std::size_t>(x), segments - 1);
+        u = x - static_cast<T>(index);
+    }
+
+    template <template <typename> class Vec, typename T>
+    Vec<T> curve<Vec, T>::evaluate(const T t) const
+    {
+        if (_segments.empty())
+        {
+            return Vec<T>{};
+        }
+
+        std::size_t index;
+        T u;
+        locate(t, index, u);
+        const segment& s = _segments[index];
+        return ((s._a * u + s._b) * u + s._c) * u + s._d;
+    }
+    template <template <typename> class Vec, typename T>
+    Vec<T> curve<Vec, T>::derivative(const T t) const
+    {
+        if (_segments.empty())
+        {
+            return Vec<T>{};
+        }
+
+        std::size_t index;
+        T u;
+        locate(t, index, u);
+        const segment& s = _segments[index];
+        const T scale = static_cast<T>(_segments.size());
+        return ((s._a * (3 * u) + s._b * 2) * u + s._c) * scale;
+    }
+    template <template <typename> class Vec, typename T>
+    Vec<T> curve<Vec, T>::second_derivative(const T t) const
+    {
+        if (_segments.empty())
+        {
+            return Vec<T>{};
+        }
+
+        std::size_t index;
+        T u;
+        locate(t, index, u);
+        const segment& s = _segments[index];
+        const T scale = static_cast<T>(_segments.size());
+        return (s._a * (6 * u) + s._b * 2) * (scale * scale);
+    }
+
+    /* the segment lookup runs as its own pass over a block ahead of the horner step; t is clamped to
+       [0, 1], so truncation stands in for std::floor, which compiles to a libm call on baseline x86-64 */
+    template <template <typename> class Vec, typename T>
+    template <typename F>
+    void curve<Vec, T>::batch(const T* t, Vec<T>* out, const std::size_t count, F f) const
+    {
+        const std::size_t segments = _segments.size();
+        if (segments == 0)
+        {
+            std::fill(out, out + count, Vec<T>{});
+            return;
+        }
+
+        constexpr std::size_t block = 64;
+        std::uint32_t index[block];
+        T u[block];
+
+        const T scale = static_cast<T>(segments);
+        const std::int32_t last = static_cast<std::int32_t>(segments - 1);
+
+        for (std::size_t base = 0; base < count; base += block)
+        {
+            const std::size_t n = std::min(block, count - base);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T x = std::min(std::max(t[base + i], T{ 0 }), T{ 1 }) * scale;
+                const std::int32_t s = std::min(static_cast<std::int32_t>(x), last);
+                index[i] = static_cast<std::uint32_t>(s);
+                u[i] = x - static_cast<T>(s);
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[base + i] = f(_segments[index[i]], u[i]);
+            }
+        }
+    }
+
+    template <template <typename> class Vec, typename T>
+    void curve<Vec, T>::evaluate(const T* t, Vec<T>* out, const std::size_t count) const
+    {
+        MCPGNZ_PROFILE_BATCH(T, "curve::evaluate", count);
+        batch(t, out, count, [](const segment& s, const T u)
+        {
+            return ((s._a * u + s._b) * u + s._c) * u + s._d;
+        });
+    }
+    template <template <typename> class Vec, typename T>
+    void curve<Vec, T>::derivative(const T* t, Vec<T>* out, const std::size_t count) const
+    {
+        MCPGNZ_PROFILE_BATCH(T, "curve::derivative", count);
+        const T scale = static_cast<T>(_segments.size());
+        batch(t, out, count, [scale](const segment& s, const T u)
+        {
+            return ((s._a * (3 * u) + s._b * 2) * u + s._c) * scale;
+        });
+    }
+    template <template <typename> class Vec, typename T>
+    void curve<Vec, T>::second_derivative(const T* t, Vec<T>* out, const std::size_t count) const
+    {
+        MCPGNZ_PROFILE_BATCH(T, "curve::second_derivative", count);
+        const T scale = static_cast<T>(_segments.size());
+        batch(t, out, count, [scale](const segment& s, const T u)
+        {
+            return (s._a * (6 * u) + s._b * 2) * (scale * scale);
+        });
+    }
+
+    template <template <typename> class Vec, typename T>
+    void curve<Vec, T>::evaluate_uniform(Vec<T>* out, const std::size_t count) const
+    {
+        MCPGNZ_PROFILE_BATCH(T, "curve::evaluate_uniform", count);
+        if (count < 2)
+        {
+            if (count == 1)
+            {
+                out[0] = evaluate(0);
+            }
+            return;
+        }
+
+        using A = typename detail::curve_accumulator<T>::type;
+
+        const std::size_t segments = _segments.size();
+        if (segments == 0)
+        {
+            std::fill(out, out + count, Vec<T>{});
+            return;
+        }
+
+        const A h = static_cast<A>(segments) / static_cast<A>(count - 1);
+        const A h2 = h * h;
+        const A h3 = h2 * h;
+
+        std::size_t i = 0;
+        for (std::size_t index = 0; index < segments && i < count; ++index)
+        {
+            /* samples whose global parameter lies in [index, index + 1), the last segment also takes t = 1 */
+            const std::size_t end = (index + 1 == segments)
+                ? count
+                : std::min(count, static_cast<std::size_t>(std::ceil(static_cast<A>(index + 1) / h)));
+
+            const segment& s = _segments[index];
+            const Vec<A> a = static_cast<Vec<A>>(s._a);
+            const Vec<A> b = static_cast<Vec<A>>(s._b);
+            const Vec<A> c = static_cast<Vec<A>>(s._c);
+            const Vec<A> d = static_cast<Vec<A>>(s._d);
+            const Vec<A> d3 = a * (6 * h3);
+
+            while (i < end)
+            {
+                const A u = static_cast<A>(i) * static_cast<A>(segments) / static_cast<A>(count - 1) - static_cast<A>(index);
+
+                Vec<A> f = ((a * u + b) * u + c) * u + d;
+                Vec<A> d1 = a * (3 * u * u * h + 3 * u * h2 + h3) + b * (2 * u * h + h2) + c * h;
+                Vec<A> d2 = a * (6 * u * h2 + 6 * h3) + b * (2 * h2);
+
+                const std::size_t block = std::min(end, i + detail::curve_reseed);
+                for (; i < block; ++i)
+                {
+                    out[i] = static_cast<Vec<T>>(f);
+                    f += d1;
+                    d1 += d2;
+                    d2 += d3;
+                }
+            }
+        }
+    }
+
+    template <template <typename> class Vec, typename T>
+    curve<Vec, T> curve<Vec, T>::bezier(const Vec<T>* points, const std::size_t count)
+    {
+        curve result;
+        result._segments.reserve(count / 3);
+        for (std::size_t i = 0; i + 3 < count; i += 3)
+        {
+            const Vec<T>& p0 = points[i];
+            const Vec<T>& p1 = points[i + 1];
+            const Vec<T>& p2 = points[i + 2];
+            const Vec<T>& p3 = points[i + 3];
+            result._segments.push_back(segment{
+                -p0 + (p1 - p2) * 3 + p3,
+                (p0 - p1 * 2 + p2) * 3,
+                (p1 - p0) * 3,
+                p0 });
+        }
+        return result;
+    }
+    template <template <typename> class Vec, typename T>
+    curve<Vec, T> curve<Vec, T>::catmull_rom(const Vec<T>* points, const std::size_t count)
+    {
+        curve result;
+        result._segments.reserve(count);
+        for (std::size_t i = 0; i + 3 < count; ++i)
+        {
+            const Vec<T>& p0 = points[i];
+            const Vec<T>& p1 = points[i + 1];
+            const Vec<T>& p2 = points[i + 2];
+            const Vec<T>& p3 = points[i + 3];
+            result._segments.push_back(segment{
+                (-p0 + (p1 - p2) * 3 + p3) * T{ 0.5 },
+                (p0 * 2 - p1 * 5 + p2 * 4 - p3) * T{ 0.5 },
+                (p2 - p0) * T{ 0.5 },
+                p1 });
+        }
+        return result;
+    }
+    template <template <typename> class Vec, typename T>
+    curve<Vec, T> curve<Vec, T>::bspline(const Vec<T>* points, const std::size_t count)
+    {
+        const T sixth = T{ 1 } / 6;
+
+        curve result;
+        result._segments.reserve(count);
+        for (std::size_t i = 0; i + 3 < count; ++i)
+        {
+            const Vec<T>& p0 = points[i];
+            const Vec<T>& p1 = points[i + 1];
+            const Vec<T>& p2 = points[i + 2];
+            const Vec<T>& p3 = points[i + 3];
+            result._segments.push_back(segment{
+                (-p0 + (p1 - p2) * 3 + p3) * sixth,
+                (p0 - p1 * 2 + p2) * (3 * sixth),
+                (p2 - p0) * (3 * sixth),
+                (p0 + p1 * 4 + p2) * sixth });
+        }
+        return result;
+    }
+
+    template <typename T>
+    template <template <typename> class Vec>
+    arc_length_table<T>::arc_length_table(const curve<Vec, T>& source, const std::size_t resolution)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "arc_length_table", resolution);
+        const std::size_t samples = std::max<std::size_t>(resolution, 2);
+        std::vector<Vec<T>> points(samples);
+        source.evaluate_uniform(points.data(), samples);
+
+        _lengths.resize(samples);
+        _lengths[0] = 0;
+        for (std::size_t i = 1; i < samples; ++i)
+        {
+            _lengths[i] = _lengths[i - 1] + detail::length(points[i] - points[i - 1]);
+        }
+    }
+
+    template <typename T>
+    T arc_length_table<T>::length() const
+    {
+        return _lengths.back();
+    }
+
+    template <typename T>
+    T arc_length_table<T>::parameter_at(const T distance) const
+    {
+        const std::size_t last = _lengths.size() - 1;
+        if (distance <= 0)
+        {
+            return 0;
+        }
+        if (distance >= _lengths[last])
+        {
+            return 1;
+        }
+
+        const std::size_t upper = static_cast<std::size_t>(
+            std::upper_bound(_lengths.begin(), _lengths.end(), distance) - _lengths.begin());
+        const std::size_t lower = upper - 1;
+        const T span = _lengths[upper] - _lengths[lower];
+        const T fraction = span > 0 ? (distance - _lengths[lower]) / span : T{ 0 };
+        return (static_cast<T>(lower) + fraction) / static_cast<T>(last);
+    }
+
+    /* ascending distances, as produced when walking a curve, continue the search from the previous hit
+       and only fall back to binary search when the input steps backwards */
+    template <typename T>
+    void arc_length_table<T>::parameter_at(const T* distances, T* out, const std::size_t count) const
+    {
+        MCPGNZ_PROFILE_BATCH(T, "arc_length_table::parameter_at", count);
+        const std::size_t last = _lengths.size() - 1;
+        std::size_t upper = 1;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const T distance = distances[i];
+            if (distance <= 0)
+            {
+                out[i] = 0;
+                continue;
+            }
+            if (distance >= _lengths[last])
+            {
+                out[i] = 1;
+                continue;
+            }
+
+            if (_lengths[upper - 1] > distance)
+            {
+                upper = static_cast<std::size_t>(
+                    std::upper_bound(_lengths.begin(), _lengths.end(), distance) - _lengths.begin());
+            }
+            while (_lengths[upper] <= distance)
+            {
+                ++upper;
+            }
+
+            const std::size_t lower = upper - 1;
+            const T span = _lengths[upper] - _lengths[lower];
+            const T fraction = span > 0 ? (distance - _lengths[lower]) / span : T{ 0 };
+            out[i] = (static_cast<T>(lower) + fraction) / static_cast<T>(last);
+        }
+    }
+    #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
\ No newline at end of file
@@ -0,0 +1,457 @@
+#pragma once
+
+/* define MCPGNZ_PROFILE to count vector operators per type and to time the batch kernels; without
+   it the hooks below expand to nothing and none of the profiling interface is declared;
+   the hooks change the bodies of inline templates, so the macro has to be set project wide as a
+   compiler flag (/DMCPGNZ_PROFILE, -DMCPGNZ_PROFILE) rather than in single translation units:
+   profiled builds declare everything inside the inline namespace mcpgnz::profiled so both variants
+   never share a symbol, and msvc refuses to link objects built with different settings */
+#ifdef MCPGNZ_PROFILE
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+    #define MCPGNZ_PROFILE_NAMESPACE_BEGIN inline namespace profiled {
+    #define MCPGNZ_PROFILE_NAMESPACE_END }
+
+    #ifdef _MSC_VER
+        #pragma detect_mismatch("MCPGNZ_PROFILE", "1")
+    #endif
+
+    #define MCPGNZ_PROFILE_CONCAT_INNER(a, b) a##b
+    #define MCPGNZ_PROFILE_CONCAT(a, b) MCPGNZ_PROFILE_CONCAT_INNER(a, b)
+
+    #define MCPGNZ_PROFILE_OP(dimension, T, op)                                                          \
+        static ::mcpgnz::profile_entry& MCPGNZ_PROFILE_CONCAT(mcpgnz_profile_, __LINE__) =               \
+            ::mcpgnz::profile_entry_for(::mcpgnz::detail::profile_vec_name<T>(dimension, op));           \
+        MCPGNZ_PROFILE_CONCAT(mcpgnz_profile_, __LINE__).count()
+
+    #define MCPGNZ_PROFILE_BATCH(T, name, size)                                                          \
+        static ::mcpgnz::profile_entry& MCPGNZ_PROFILE_CONCAT(mcpgnz_profile_, __LINE__) =               \
+            ::mcpgnz::profile_entry_for(::mcpgnz::detail::profile_batch_name<T>(name));                  \
+        const ::mcpgnz::profile_scope MCPGNZ_PROFILE_CONCAT(mcpgnz_profile_scope_, __LINE__){            \
+            MCPGNZ_PROFILE_CONCAT(mcpgnz_profile_, __LINE__), static_cast<std::uint64_t>(size) }
+
+namespace mcpgnz
+{
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    /* registered operator or batch kernel, its counters live in per thread buffers under _index */
+    struct profile_entry
+    {
+        std::string _name;
+        std::size_t _index;
+
+        #pragma region methods
+        profile_entry(std::string name, std::size_t index) : _name{ std::move(name) }, _index{ index } {}
+
+        profile_entry(const profile_entry& other) = delete;
+        profile_entry& operator=(const profile_entry& other) = delete;
+
+        /* operators only count calls, batch kernels also record their size and duration */
+        void count();
+        void record(std::uint64_t items, std::uint64_t nanoseconds);
+        #pragma endregion
+    };
+
+    /* copy of an entry taken for reports */
+    struct profile_record
+    {
+        std::string _name;
+        std::uint64_t _calls;
+        std::uint64_t _items;
+        std::uint64_t _largest;
+        std::uint64_t _nanoseconds;
+    };
+
+    /* times a batch kernel from construction to destruction */
+    struct profile_scope
+    {
+        profile_entry& _entry;
+        std::uint64_t _items;
+        std::chrono::steady_clock::time_point _start;
+
+        #pragma region methods
+        profile_scope(profile_entry& entry, std::uint64_t items);
+
+        profile_scope(const profile_scope& other) = delete;
+        profile_scope& operator=(const profile_scope& other) = delete;
+
+        ~profile_scope();
+        #pragma endregion
+    };
+
+    using profile_callback = std::function<void(const std::vector<profile_record>&)>;
+
+    #pragma region profiling
+    profile_entry& profile_entry_for(const std::string& name);
+
+    /* records sorted by time spent, then by call count; counts of running threads are included */
+    std::vector<profile_record> profile_snapshot();
+    void profile_report(std::ostream& out);
+    /* a count racing the reset on another thread may survive it */
+    void profile_reset();
+
+    /* replaces the report written to std::cerr at exit */
+    void profile_at_exit(profile_callback callback);
+    #pragma endregion
+
+    #pragma region implementation
+    namespace detail
+    {
+        /* counters of one entry on one thread; only the owning thread writes them, with a relaxed load
+           and store instead of a locked read modify write, reports and resets may read them meanwhile */
+        struct profile_counters
+        {
+            std::atomic<std::uint64_t> _calls{ 0 };
+            std::atomic<std::uint64_t> _items{ 0 };
+            std::atomic<std::uint64_t> _largest{ 0 };
+            std::atomic<std::uint64_t> _nanoseconds{ 0 };
+        };
+
+        inline void profile_add(std::atomic<std::uint64_t>& counter, const std::uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        inline void profile_max(std::atomic<std::uint64_t>& counter, const std::uint64_t value)
+        {
+            if (value > counter.load(std::memory_order_relaxed))
+            {
+                counter.store(value, std::memory_order_relaxed);
+            }
+        }
+
+        /* one per thread, registered while the thread runs and merged into the registry when it ends */
+        struct profile_buffer
+        {
+            std::deque<profile_counters> _counters;
+
+            #pragma region methods
+            profile_buffer();
+
+            profile_buffer(const profile_buffer& other) = delete;
+            profile_buffer& operator=(const profile_buffer& other) = delete;
+
+            ~profile_buffer();
+
+            profile_counters& at(std::size_t index);
+            #pragma endregion
+        };
+
+        struct profile_registry
+        {
+            std::mutex _mutex;
+            std::deque<profile_entry> _entries;
+            std::map<std::string, profile_entry*> _lookup;
+            std::vector<profile_buffer*> _buffers;
+            /* counts of threads that already ended, per entry */
+            std::deque<profile_counters> _retired;
+            profile_callback _callback;
+        };
+
+        inline void profile_exit();
+
+        /* never destroyed, so static destructors and threads outliving main may still count;
+           the final report is handed out from std::atexit instead */
+        inline profile_registry& profile_instance()
+        {
+            static profile_registry* const registry = []
+            {
+                profile_registry* created = new profile_registry{};
+                std::atexit(profile_exit);
+                return created;
+            }();
+            return *registry;
+        }
+
+        /* set once the buffer of this thread is merged, it is trivially destructible and stays usable after that */
+        inline bool& profile_ended()
+        {
+            thread_local bool ended = false;
+            return ended;
+        }
+
+        inline profile_buffer& profile_local()
+        {
+            thread_local profile_buffer buffer;
+            return buffer;
+        }
+
+        /* counts from destructors that run after the buffer of their thread is gone go to the registry under its lock */
+        template <typename F>
+        void profile_update(const std::size_t index, F update)
+        {
+            if (profile_ended())
+            {
+                profile_registry& registry = profile_instance();
+                std::lock_guard<std::mutex> lock{ registry._mutex };
+                update(registry._retired[index]);
+                return;
+            }
+            update(profile_local().at(index));
+        }
+
+        inline void profile_merge(profile_counters& into, const profile_counters& from)
+        {
+            profile_add(into._calls, from._calls.load(std::memory_order_relaxed));
+            profile_add(into._items, from._items.load(std::memory_order_relaxed));
+            profile_max(into._largest, from._largest.load(std::memory_order_relaxed));
+            profile_add(into._nanoseconds, from._nanoseconds.load(std::memory_order_relaxed));
+        }
+
+        inline profile_buffer::profile_buffer()
+        {
+            profile_registry& registry = profile_instance();
+            std::lock_guard<std::mutex> lock{ registry._mutex };
+            registry._buffers.push_back(this);
+        }
+
+        inline profile_buffer::~profile_buffer()
+        {
+            profile_registry& registry = profile_instance();
+            std::lock_guard<std::mutex> lock{ registry._mutex };
+            for (std::size_t i = 0; i < _counters.size(); ++i)
+            {
+                profile_merge(registry._retired[i], _counters[i]);
+            }
+            registry._buffers.erase(std::find(registry._buffers.begin(), registry._buffers.end(), this));
+            profile_ended() = true;
+        }
+
+        /* growing takes the registry lock since reports walk every buffer, the deque keeps counters in place */
+        inline profile_counters& profile_buffer::at(const std::size_t index)
+        {
+            if (index >= _counters.size())
+            {
+                std::lock_guard<std::mutex> lock{ profile_instance()._mutex };
+                while (index >= _counters.size())
+                {
+                    _counters.emplace_back();
+                }
+            }
+            return _counters[index];
+        }
+
+        template <typename T> const char* profile_suffix() { return "?"; }
+        template <> inline const char* profile_suffix<double>() { return "d"; }
+        template <> inline const char* profile_suffix<float>() { return "f"; }
+        template <> inline const char* profile_suffix<std::int32_t>() { return "i"; }
+        template <> inline const char* profile_suffix<std::uint32_t>() { return "u"; }
+        template <> inline const char* profile_suffix<std::uint8_t>() { return "u8"; }
+        template <> inline const char* profile_suffix<std::int64_t>() { return "i64"; }
+        template <> inline const char* profile_suffix<std::uint64_t>() { return "u64"; }
+
+        template <typename T> std::string profile_vec_name(const int dimension, const char* op)
+        {
+            return "vec" + std::to_string(dimension) + profile_suffix<T>() + "::" + op;
+        }
+        template <typename T> std::string profile_batch_name(const char* name)
+        {
+            return std::string{ name } + "<" + profile_suffix<T>() + ">";
+        }
+
+        inline std::vector<profile_record> profile_collect(profile_registry& registry)
+        {
+            std::vector<profile_record> records;
+            {
+                std::lock_guard<std::mutex> lock{ registry._mutex };
+                records.reserve(registry._entries.size());
+                for (const profile_entry& entry : registry._entries)
+                {
+                    profile_counters total;
+                    profile_merge(total, registry._retired[entry._index]);
+                    for (const profile_buffer* buffer : registry._buffers)
+                    {
+                        if (entry._index < buffer->_counters.size())
+                        {
+                            profile_merge(total, buffer->_counters[entry._index]);
+                        }
+                    }
+                    records.push_back(profile_record{
+                        entry._name,
+                        total._calls.load(std::memory_order_relaxed),
+                        total._items.load(std::memory_order_relaxed),
+                        total._largest.load(std::memory_order_relaxed),
+                        total._nanoseconds.load(std::memory_order_relaxed) });
+                }
+            }
+
+            std::sort(records.begin(), records.end(), [](const profile_record& lhs, const profile_record& rhs)
+            {
+                if (lhs._nanoseconds != rhs._nanoseconds)
+                {
+                    return lhs._nanoseconds > rhs._nanoseconds;
+                }
+                return lhs._calls > rhs._calls;
+            });
+            return records;
+        }
+
+        inline void profile_write(const std::vector<profile_record>& records, std::ostream& out)
+        {
+            const std::ios::fmtflags flags = out.flags();
+            const std::streamsize precision = out.precision();
+
+            out << std::left << std::setw(40) << "name"
+                << std::right << std::setw(16) << "calls"
+                << std::setw(16) << "items"
+                << std::setw(12) << "largest"
+                << std::setw(14) << "total ms"
+                << std::setw(12) << "ns/item" << '\n';
+
+            for (const profile_record& record : records)
+            {
+                out << std::left << std::setw(40) << record._name
+                    << std::right << std::setw(16) << record._calls;
+                if (record._items > 0 || record._nanoseconds > 0)
+                {
+                    out << std::setw(16) << record._items
+                        << std::setw(12) << record._largest
+                        << std::setw(14) << std::fixed << std::setprecision(3) << record._nanoseconds / 1e6
+                        << std::setw(12) << std::setprecision(2) << static_cast<double>(record._nanoseconds) / std::max<std::uint64_t>(record._items, 1);
+                }
+                out << '\n';
+            }
+
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+        /* counts made after the report, by destructors of statics created before the registry, are dropped */
+        inline void profile_exit()
+        {
+            profile_registry& registry = profile_instance();
+            profile_callback callback;
+            {
+                std::lock_guard<std::mutex> lock{ registry._mutex };
+                if (registry._entries.empty())
+                {
+                    return;
+                }
+                callback = registry._callback;
+            }
+
+            if (callback)
+            {
+                callback(profile_collect(registry));
+            }
+            else
+            {
+                profile_write(profile_collect(registry), std::cerr);
+            }
+        }
+    }
+
+    inline void profile_entry::count()
+    {
+        detail::profile_update(_index, [](detail::profile_counters& counters)
+        {
+            detail::profile_add(counters._calls, 1);
+        });
+    }
+
+    inline void profile_entry::record(const std::uint64_t items, const std::uint64_t nanoseconds)
+    {
+        detail::profile_update(_index, [=](detail::profile_counters& counters)
+        {
+            detail::profile_add(counters._calls, 1);
+            detail::profile_add(counters._items, items);
+            detail::profile_max(counters._largest, items);
+            detail::profile_add(counters._nanoseconds, nanoseconds);
+        });
+    }
+
+    inline profile_scope::profile_scope(profile_entry& entry, const std::uint64_t items)
+        : _entry{ entry }
+        , _items{ items }
+        , _start{ std::chrono::steady_clock::now() }
+    {
+    }
+
+    inline profile_scope::~profile_scope()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - _start;
+        _entry.record(_items, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    inline profile_entry& profile_entry_for(const std::string& name)
+    {
+        detail::profile_registry& registry = detail::profile_instance();
+        std::lock_guard<std::mutex> lock{ registry._mutex };
+
+        const auto found = registry._lookup.find(name);
+        if (found != registry._lookup.end())
+        {
+            return *found->second;
+        }
+        registry._entries.emplace_back(name, registry._entries.size());
+        registry._retired.emplace_back();
+        registry._lookup.emplace(name, &registry._entries.back());
+        return registry._entries.back();
+    }
+
+    inline std::vector<profile_record> profile_snapshot()
+    {
+        return detail::profile_collect(detail::profile_instance());
+    }
+
+    inline void profile_report(std::ostream& out)
+    {
+        detail::profile_write(profile_snapshot(), out);
+    }
+
+    inline void profile_reset()
+    {
+        detail::profile_registry& registry = detail::profile_instance();
+        std::lock_guard<std::mutex> lock{ registry._mutex };
+        const auto clear = [](detail::profile_counters& counters)
+        {
+            counters._calls.store(0, std::memory_order_relaxed);
+            counters._items.store(0, std::memory_order_relaxed);
+            counters._largest.store(0, std::memory_order_relaxed);
+            counters._nanoseconds.store(0, std::memory_order_relaxed);
+        };
+        for (detail::profile_counters& counters : registry._retired)
+        {
+            clear(counters);
+        }
+        for (detail::profile_buffer* buffer : registry._buffers)
+        {
+            for (detail::profile_counters& counters : buffer->_counters)
+            {
+                clear(counters);
+            }
+        }
+    }
+
+    inline void profile_at_exit(profile_callback callback)
+    {
+        detail::profile_registry& registry = detail::profile_instance();
+        std::lock_guard<std::mutex> lock{ registry._mutex };
+        registry._callback = std::move(callback);
+    }
+    #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
+#else
+    #define MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    #define MCPGNZ_PROFILE_NAMESPACE_END
+
+    #ifdef _MSC_VER
+        #pragma detect_mismatch("MCPGNZ_PROFILE", "0")
+    #endif
+
+    #define MCPGNZ_PROFILE_OP(dimension, T, op)
+    #define MCPGNZ_PROFILE_BATCH(T, name, size)
+#endif
@@ -0,0 +1,323 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+namespace mcpgnz
+{
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    /* counter-based Philox4x32-10 generator, every (seed, stream) pair is an independent sequence */
+    struct philox
+    {
+        vec4u _counter;
+        vec2u _key;
+
+        #pragma region methods
+        philox(std::uint64_t seed, std::uint64_t stream = 0);
+
+        philox(const philox& other) = default;
+        philox& operator=(const philox& other) = default;
+
+        philox(philox&& other) = default;
+        philox& operator=(philox&& other) = default;
+
+        ~philox() = default;
+
+        vec4u operator()();
+        void fill(std::uint32_t* out, std::size_t count);
+        void discard(std::uint64_t blocks);
+        #pragma endregion
+
+        #pragma region statics
+        static constexpr std::size_t _lanes = 8;
+        #pragma endregion
+    };
+
+    #pragma region sampling
+    template <typename T> void sample_uniform(philox& rng, T* out, std::size_t count);
+    template <typename T> void sample_uniform(philox& rng, vec2<T>* out, std::size_t count);
+    template <typename T> void sample_uniform(philox& rng, vec3<T>* out, std::size_t count);
+
+    template <typename T> void sample_sphere(philox& rng, vec3<T>* out, std::size_t count);
+    template <typename T> void sample_sphere(philox& rng, T* x, T* y, T* z, std::size_t count);
+
+    template <typename T> void sample_hemisphere(philox& rng, vec3<T>* out, std::size_t count);
+    template <typename T> void sample_hemisphere(philox& rng, T* x, T* y, T* z, std::size_t count);
+
+    template <typename T> void sample_cosine_hemisphere(philox& rng, vec3<T>* out, std::size_t count);
+    template <typename T> void sample_cosine_hemisphere(philox& rng, T* x, T* y, T* z, std::size_t count);
+
+    template <typename T> void sample_disk(philox& rng, vec2<T>* out, std::size_t count);
+    template <typename T> void sample_disk(philox& rng, T* x, T* y, std::size_t count);
+    #pragma endregion
+
+    #pragma region implementation
+    namespace detail
+    {
+        constexpr std::uint32_t philox_m0 = 0xD2511F53u;
+        constexpr std::uint32_t philox_m1 = 0xCD9E8D57u;
+        constexpr std::uint32_t philox_w0 = 0x9E3779B9u;
+        constexpr std::uint32_t philox_w1 = 0xBB67AE85u;
+        constexpr int philox_rounds = 10;
+
+        /* the blocks are kept in separate lanes so the rounds vectorize across them */
+        inline void philox_blocks(std::uint32_t* c0, std::uint32_t* c1, std::uint32_t* c2, std::uint32_t* c3,
+            std::uint32_t k0, std::uint32_t k1, const std::size_t lanes)
+        {
+            for (int round = 0; round < philox_rounds; ++round)
+            {
+                for (std::size_t i = 0; i < lanes; ++i)
+                {
+                    const std::uint64_t p0 = static_cast<std::uint64_t>(philox_m0) * c0[i];
+                    const std::uint64_t p1 = static_cast<std::uint64_t>(philox_m1) * c2[i];
+                    const std::uint32_t x1 = c1[i];
+                    const std::uint32_t x3 = c3[i];
+
+                    c0[i] = static_cast<std::uint32_t>(p1 >> 32) ^ x1 ^ k0;
+                    c1[i] = static_cast<std::uint32_t>(p1);
+                    c2[i] = static_cast<std::uint32_t>(p0 >> 32) ^ x3 ^ k1;
+                    c3[i] = static_cast<std::uint32_t>(p0);
+                }
+                k0 += philox_w0;
+                k1 += philox_w1;
+            }
+        }
+
+        /* a float sample takes 24 bits of one word, a double sample 53 bits of two */
+        template <typename T> struct unit_words;
+        template <> struct unit_words<float> { static constexpr std::size_t value = 1; };
+        template <> struct unit_words<double> { static constexpr std::size_t value = 2; };
+
+        template <typename T> T to_unit(const std::uint32_t* bits);
+        template <> inline float to_unit<float>(const std::uint32_t* bits)
+        {
+            return static_cast<float>(bits[0] >> 8) * (1.0f / 16777216.0f);
+        }
+        template <> inline double to_unit<double>(const std::uint32_t* bits)
+        {
+            const std::uint64_t mantissa = (static_cast<std::uint64_t>(bits[0]) << 21) | (bits[1] >> 11);
+            return static_cast<double>(mantissa) * (1.0 / 9007199254740992.0);
+        }
+
+        template <typename T> constexpr T two_pi()
+        {
+            return static_cast<T>(6.283185307179586476925286766559);
+        }
+
+        /* draws pairs of unit numbers in chunks, maps them to a sample and hands it to the store */
+        template <typename T, typename Map, typename Store>
+        void sample_2d(philox& rng, const std::size_t count, Map map, Store store)
+        {
+            constexpr std::size_t chunk = 256;
+            constexpr std::size_t words = unit_words<T>::value;
+            std::uint32_t bits[2 * words * chunk];
+
+            for (std::size_t base = 0; base < count; base += chunk)
+            {
+                const std::size_t n = std::min(chunk, count - base);
+                rng.fill(bits, 2 * words * n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const std::uint32_t* sample = bits + 2 * words * i;
+                    store(base + i, map(to_unit<T>(sample), to_unit<T>(sample + words)));
+                }
+            }
+        }
+
+        template <typename T> vec3<T> map_sphere(const T u1, const T u2)
+        {
+            const T z = 1 - 2 * u1;
+            const T r = std::sqrt(std::max(T{ 0 }, 1 - z * z));
+            const T phi = two_pi<T>() * u2;
+            return vec3<T>{ r * std::cos(phi), r * std::sin(phi), z };
+        }
+        template <typename T> vec3<T> map_hemisphere(const T u1, const T u2)
+        {
+            const T z = u1;
+            const T r = std::sqrt(std::max(T{ 0 }, 1 - z * z));
+            const T phi = two_pi<T>() * u2;
+            return vec3<T>{ r * std::cos(phi), r * std::sin(phi), z };
+        }
+        template <typename T> vec3<T> map_cosine_hemisphere(const T u1, const T u2)
+        {
+            const T r = std::sqrt(u1);
+            const T phi = two_pi<T>() * u2;
+            return vec3<T>{ r * std::cos(phi), r * std::sin(phi), std::sqrt(1 - u1) };
+        }
+        template <typename T> vec2<T> map_disk(const T u1, const T u2)
+        {
+            const T r = std::sqrt(u1);
+            const T phi = two_pi<T>() * u2;
+            return vec2<T>{ r * std::cos(phi), r * std::sin(phi) };
+        }
+
+        template <typename T> auto store_aos(vec3<T>* out)
+        {
+            return [out](const std::size_t i, const vec3<T>& v) { out[i] = v; };
+        }
+        template <typename T> auto store_aos(vec2<T>* out)
+        {
+            return [out](const std::size_t i, const vec2<T>& v) { out[i] = v; };
+        }
+        template <typename T> auto store_soa(T* x, T* y, T* z)
+        {
+            return [x, y, z](const std::size_t i, const vec3<T>& v) { x[i] = v._x; y[i] = v._y; z[i] = v._z; };
+        }
+        template <typename T> auto store_soa(T* x, T* y)
+        {
+            return [x, y](const std::size_t i, const vec2<T>& v) { x[i] = v._x; y[i] = v._y; };
+        }
+    }
+
+    inline philox::philox(const std::uint64_t seed, const std::uint64_t stream)
+        : _counter{ 0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) }
+        , _key{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) }
+    {
+    }
+
+    inline vec4u philox::operator()()
+    {
+        std::uint32_t c0 = _counter._x, c1 = _counter._y, c2 = _counter._z, c3 = _counter._w;
+        detail::philox_blocks(&c0, &c1, &c2, &c3, _key._x, _key._y, 1);
+        discard(1);
+        return vec4u{ c0, c1, c2, c3 };
+    }
+
+    inline void philox::fill(std::uint32_t* out, const std::size_t count)
+    {
+        std::uint32_t c0[_lanes], c1[_lanes], c2[_lanes], c3[_lanes];
+        std::size_t written = 0;
+
+        while (count - written >= 4 * _lanes)
+        {
+            const std::uint64_t block = (static_cast<std::uint64_t>(_counter._y) << 32) | _counter._x;
+            for (std::size_t i = 0; i < _lanes; ++i)
+            {
+                c0[i] = static_cast<std::uint32_t>(block + i);
+                c1[i] = static_cast<std::uint32_t>((block + i) >> 32);
+                c2[i] = _counter._z;
+                c3[i] = _counter._w;
+            }
+            detail::philox_blocks(c0, c1, c2, c3, _key._x, _key._y, _lanes);
+            for (std::size_t i = 0; i < _lanes; ++i)
+            {
+                out[written++] = c0[i];
+                out[written++] = c1[i];
+                out[written++] = c2[i];
+                out[written++] = c3[i];
+            }
+            discard(_lanes);
+        }
+
+        while (written < count)
+        {
+            const vec4u block = (*this)();
+            for (int i = 0; i < 4 && written < count; ++i)
+            {
+                out[written++] = block[i];
+            }
+        }
+    }
+
+    inline void philox::discard(const std::uint64_t blocks)
+    {
+        const std::uint64_t block = ((static_cast<std::uint64_t>(_counter._y) << 32) | _counter._x) + blocks;
+        _counter._x = static_cast<std::uint32_t>(block);
+        _counter._y = static_cast<std::uint32_t>(block >> 32);
+    }
+
+    template <typename T> void sample_uniform(philox& rng, T* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_uniform", count);
+        constexpr std::size_t chunk = 512;
+        constexpr std::size_t words = detail::unit_words<T>::value;
+        std::uint32_t bits[words * chunk];
+
+        for (std::size_t base = 0; base < count; base += chunk)
+        {
+            const std::size_t n = std::min(chunk, count - base);
+            rng.fill(bits, words * n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[base + i] = detail::to_unit<T>(bits + words * i);
+            }
+        }
+    }
+    template <typename T> void sample_uniform(philox& rng, vec2<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_uniform", count);
+        detail::sample_2d<T>(rng, count, [](const T u1, const T u2) { return vec2<T>{ u1, u2 }; }, detail::store_aos(out));
+    }
+    template <typename T> void sample_uniform(philox& rng, vec3<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_uniform", count);
+        constexpr std::size_t chunk = 256;
+        constexpr std::size_t words = detail::unit_words<T>::value;
+        std::uint32_t bits[3 * words * chunk];
+
+        for (std::size_t base = 0; base < count; base += chunk)
+        {
+            const std::size_t n = std::min(chunk, count - base);
+            rng.fill(bits, 3 * words * n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const std::uint32_t* sample = bits + 3 * words * i;
+                out[base + i] = vec3<T>{
+                    detail::to_unit<T>(sample),
+                    detail::to_unit<T>(sample + words),
+                    detail::to_unit<T>(sample + 2 * words) };
+            }
+        }
+    }
+
+    template <typename T> void sample_sphere(philox& rng, vec3<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_sphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_sphere<T>, detail::store_aos(out));
+    }
+    template <typename T> void sample_sphere(philox& rng, T* x, T* y, T* z, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_sphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_sphere<T>, detail::store_soa(x, y, z));
+    }
+
+    template <typename T> void sample_hemisphere(philox& rng, vec3<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_hemisphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_hemisphere<T>, detail::store_aos(out));
+    }
+    template <typename T> void sample_hemisphere(philox& rng, T* x, T* y, T* z, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_hemisphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_hemisphere<T>, detail::store_soa(x, y, z));
+    }
+
+    template <typename T> void sample_cosine_hemisphere(philox& rng, vec3<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_cosine_hemisphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_cosine_hemisphere<T>, detail::store_aos(out));
+    }
+    template <typename T> void sample_cosine_hemisphere(philox& rng, T* x, T* y, T* z, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_cosine_hemisphere", count);
+        detail::sample_2d<T>(rng, count, detail::map_cosine_hemisphere<T>, detail::store_soa(x, y, z));
+    }
+
+    template <typename T> void sample_disk(philox& rng, vec2<T>* out, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_disk", count);
+        detail::sample_2d<T>(rng, count, detail::map_disk<T>, detail::store_aos(out));
+    }
+    template <typename T> void sample_disk(philox& rng, T* x, T* y, const std::size_t count)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "sample_disk", count);
+        detail::sample_2d<T>(rng, count, detail::map_disk<T>, detail::store_soa(x, y));
+    }
+    #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
\ No newline at end of file
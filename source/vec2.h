@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <forward_list>
+#include <functional>
+
+#include "profile.h"
 
 namespace mcpgnz
 {
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
     template <typename T>
     struct vec2
     {
@@ -115,10 +120,12 @@ namespace mcpgnz
     #pragma region template implementation
     template <typename T> bool vec2<T>::operator==(const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator==");
         return (_x == rhs._x && _y == rhs._y);
     }
     template <typename T> bool vec2<T>::operator!=(const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator!=");
         return (_x != rhs._x || _y != rhs._y);
     }
 
@@ -133,50 +140,60 @@ namespace mcpgnz
 
     template <typename T> vec2<T> vec2<T>::operator-() const
     {
+        MCPGNZ_PROFILE_OP(2, T, "unary operator-");
         return vec2{ -_x, -_y };
     }
     template <typename T> vec2<T> vec2<T>::operator+() const
     {
+        MCPGNZ_PROFILE_OP(2, T, "unary operator+");
         return *this;
     }
 
     template <typename T> vec2<T> vec2<T>::operator+ (const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator+");
         return vec2{ _x + rhs._x, _y + rhs._y };
     }
     template <typename T> vec2<T> vec2<T>::operator- (const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator-");
         return vec2{ _x - rhs._x, _y - rhs._y };
     }
     template <typename T> vec2<T> vec2<T>::operator* (const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator*");
         return vec2{ _x * rhs._x, _y * rhs._y };
     }
     template <typename T> vec2<T> vec2<T>::operator/ (const vec2<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator/");
         return vec2{ _x / rhs._x, _y / rhs._y };
     }
 
     template <typename T> vec2<T>& vec2<T>::operator+= (const vec2<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator+=");
         _x += rhs._x;
         _y += rhs._y;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator-= (const vec2<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator-=");
         _x -= rhs._x;
         _y -= rhs._y;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator*= (const vec2<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator*=");
         _x *= rhs._x;
         _y *= rhs._y;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator/= (const vec2<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator/=");
         _x /= rhs._x;
         _y /= rhs._y;
         return *this;
@@ -184,42 +201,50 @@ namespace mcpgnz
 
     template <typename T> vec2<T> vec2<T>::operator+ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator+ scalar");
         return vec2{ _x + rhs, _y + rhs };
     }
     template <typename T> vec2<T> vec2<T>::operator- (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator- scalar");
         return vec2{ _x - rhs, _y - rhs };
     }
     template <typename T> vec2<T> vec2<T>::operator* (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator* scalar");
         return vec2{ _x * rhs, _y * rhs };
     }
     template <typename T> vec2<T> vec2<T>::operator/ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator/ scalar");
         const T inv = 1 / rhs;
         return vec2{ _x * inv, _y * inv };
     }
 
     template <typename T> vec2<T>& vec2<T>::operator+= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator+= scalar");
         _x += rhs;
         _y += rhs;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator-= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator-= scalar");
         _x -= rhs;
         _y -= rhs;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator*= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator*= scalar");
         _x *= rhs;
         _y *= rhs;
         return *this;
     }
     template <typename T> vec2<T>& vec2<T>::operator/= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "operator/= scalar");
         const T inv = 1 / rhs;
         _x *= inv;
         _y *= inv;
@@ -236,7 +261,24 @@ namespace mcpgnz
     }
     template <typename T> vec2<T> operator/(const T scalar, const vec2<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(2, T, "scalar operator/");
         return vec2<T>{ scalar / rhs.x, scalar / rhs.y };
     }
     #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
+
+namespace std
+{
+    template <typename T>
+    struct hash<mcpgnz::vec2<T>>
+    {
+        size_t operator()(const mcpgnz::vec2<T>& v) const
+        {
+            const hash<T> hasher;
+            size_t seed = hasher(v._x);
+            seed ^= hasher(v._y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
 }
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <forward_list>
+#include <functional>
+
+#include "profile.h"
 
 namespace mcpgnz
 {
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
     template <typename T>
     struct vec3
     {
@@ -118,10 +123,12 @@ namespace mcpgnz
     #pragma region template implementation
     template <typename T> bool vec3<T>::operator==(const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator==");
         return (_x == rhs._x && _y == rhs._y && _z == rhs._z);
     }
     template <typename T> bool vec3<T>::operator!=(const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator!=");
         return (_x != rhs._x || _y != rhs._y || _z != rhs._z);
     }
 
@@ -136,32 +143,39 @@ namespace mcpgnz
 
     template <typename T> vec3<T> vec3<T>::operator-() const
     {
+        MCPGNZ_PROFILE_OP(3, T, "unary operator-");
         return vec3{ -_x, -_y, -_z };
     }
     template <typename T> vec3<T> vec3<T>::operator+() const
     {
+        MCPGNZ_PROFILE_OP(3, T, "unary operator+");
         return *this;
     }
 
     template <typename T> vec3<T> vec3<T>::operator+ (const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator+");
         return vec3{ _x + rhs._x, _y + rhs._y, _z + rhs._z };
     }
     template <typename T> vec3<T> vec3<T>::operator- (const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator-");
         return vec3{ _x - rhs._x, _y - rhs._y, _z - rhs._z };
     }
     template <typename T> vec3<T> vec3<T>::operator* (const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator*");
         return vec3{ _x * rhs._x, _y * rhs._y, _z * rhs._z };
     }
     template <typename T> vec3<T> vec3<T>::operator/ (const vec3<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator/");
         return vec3{ _x / rhs._x, _y / rhs._y, _z / rhs._z };
     }
 
     template <typename T> vec3<T>& vec3<T>::operator+= (const vec3<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator+=");
         _x += rhs._x;
         _y += rhs._y;
         _z += rhs._z;
@@ -169,6 +183,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator-= (const vec3<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator-=");
         _x -= rhs._x;
         _y -= rhs._y;
         _z -= rhs._z;
@@ -176,6 +191,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator*= (const vec3<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator*=");
         _x *= rhs._x;
         _y *= rhs._y;
         _z *= rhs._z;
@@ -183,6 +199,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator/= (const vec3<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator/=");
         _x /= rhs._x;
         _y /= rhs._y;
         _z /= rhs._z;
@@ -191,24 +208,29 @@ namespace mcpgnz
 
     template <typename T> vec3<T> vec3<T>::operator+ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator+ scalar");
         return vec3{ _x + rhs, _y + rhs, _z + rhs };
     }
     template <typename T> vec3<T> vec3<T>::operator- (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator- scalar");
         return vec3{ _x - rhs, _y - rhs, _z - rhs };
     }
     template <typename T> vec3<T> vec3<T>::operator* (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator* scalar");
         return vec3{ _x * rhs, _y * rhs, _z * rhs };
     }
     template <typename T> vec3<T> vec3<T>::operator/ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator/ scalar");
         const T inv = 1 / rhs;
         return vec3{ _x * inv, _y * inv, _z * inv };
     }
 
     template <typename T> vec3<T>& vec3<T>::operator+= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator+= scalar");
         _x += rhs;
         _y += rhs;
         _z += rhs;
@@ -216,6 +238,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator-= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator-= scalar");
         _x -= rhs;
         _y -= rhs;
         _z -= rhs;
@@ -223,6 +246,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator*= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator*= scalar");
         _x *= rhs;
         _y *= rhs;
         _z *= rhs;
@@ -230,6 +254,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T>& vec3<T>::operator/= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "operator/= scalar");
         const T inv = 1 / rhs;
         _x *= inv;
         _y *= inv;
@@ -247,6 +272,7 @@ namespace mcpgnz
     }
     template <typename T> vec3<T> operator/(const T scalar, const vec3<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(3, T, "scalar operator/");
         return vec3<T>{
             scalar / rhs.x,
                 scalar / rhs.y,
@@ -254,4 +280,21 @@ namespace mcpgnz
         };
     }
     #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
+
+namespace std
+{
+    template <typename T>
+    struct hash<mcpgnz::vec3<T>>
+    {
+        size_t operator()(const mcpgnz::vec3<T>& v) const
+        {
+            const hash<T> hasher;
+            size_t seed = hasher(v._x);
+            seed ^= hasher(v._y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hasher(v._z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
 }
\ No newline at end of file
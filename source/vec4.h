@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <forward_list>
+#include <functional>
+
+#include "profile.h"
 
 namespace mcpgnz
 {
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
     template <typename T>
     struct vec4
     {
@@ -114,10 +119,12 @@ namespace mcpgnz
     #pragma region template implementation
     template <typename T> bool vec4<T>::operator==(const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator==");
         return (_x == rhs._x && _y == rhs._y && _z == rhs._z && _w == rhs._w);
     }
     template <typename T> bool vec4<T>::operator!=(const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator!=");
         return (_x != rhs._x || _y != rhs._y || _z != rhs._z || _w != rhs._w);
     }
 
@@ -132,32 +139,39 @@ namespace mcpgnz
 
     template <typename T> vec4<T> vec4<T>::operator-() const
     {
+        MCPGNZ_PROFILE_OP(4, T, "unary operator-");
         return vec4{ -_x, -_y, -_z, -_w };
     }
     template <typename T> vec4<T> vec4<T>::operator+() const
     {
+        MCPGNZ_PROFILE_OP(4, T, "unary operator+");
         return *this;
     }
 
     template <typename T> vec4<T> vec4<T>::operator+ (const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator+");
         return vec4{ _x + rhs._x, _y + rhs._y, _z + rhs._z, _w + rhs._w };
     }
     template <typename T> vec4<T> vec4<T>::operator- (const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator-");
         return vec4{ _x - rhs._x, _y - rhs._y, _z - rhs._z, _w - rhs._w };
     }
     template <typename T> vec4<T> vec4<T>::operator* (const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator*");
         return vec4{ _x * rhs._x, _y * rhs._y, _z * rhs._z, _w * rhs._w };
     }
     template <typename T> vec4<T> vec4<T>::operator/ (const vec4<T>& rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator/");
         return vec4{ _x / rhs._x, _y / rhs._y, _z / rhs._z, _w / rhs._w };
     }
 
     template <typename T> vec4<T>& vec4<T>::operator+= (const vec4<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator+=");
         _x += rhs._x;
         _y += rhs._y;
         _z += rhs._z;
@@ -166,6 +180,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator-= (const vec4<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator-=");
         _x -= rhs._x;
         _y -= rhs._y;
         _z -= rhs._z;
@@ -174,6 +189,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator*= (const vec4<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator*=");
         _x *= rhs._x;
         _y *= rhs._y;
         _z *= rhs._z;
@@ -182,6 +198,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator/= (const vec4<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator/=");
         _x /= rhs._x;
         _y /= rhs._y;
         _z /= rhs._z;
@@ -191,24 +208,29 @@ namespace mcpgnz
 
     template <typename T> vec4<T> vec4<T>::operator+ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator+ scalar");
         return vec4{ _x + rhs, _y + rhs, _z + rhs, _w + rhs };
     }
     template <typename T> vec4<T> vec4<T>::operator- (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator- scalar");
         return vec4{ _x - rhs, _y - rhs, _z - rhs, _w - rhs };
     }
     template <typename T> vec4<T> vec4<T>::operator* (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator* scalar");
         return vec4{ _x * rhs, _y * rhs, _z * rhs, _w * rhs };
     }
     template <typename T> vec4<T> vec4<T>::operator/ (const T rhs) const
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator/ scalar");
         const T inv = 1 / rhs;
         return vec4{ _x * inv, _y * inv, _z * inv, _w * inv };
     }
 
     template <typename T> vec4<T>& vec4<T>::operator+= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator+= scalar");
         _x += rhs;
         _y += rhs;
         _z += rhs;
@@ -217,6 +239,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator-= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator-= scalar");
         _x -= rhs;
         _y -= rhs;
         _z -= rhs;
@@ -225,6 +248,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator*= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator*= scalar");
         _x *= rhs;
         _y *= rhs;
         _z *= rhs;
@@ -233,6 +257,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T>& vec4<T>::operator/= (const T rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "operator/= scalar");
         const T inv = 1 / rhs;
         _x *= inv;
         _y *= inv;
@@ -251,6 +276,7 @@ namespace mcpgnz
     }
     template <typename T> vec4<T> operator/(const T scalar, const vec4<T>& rhs)
     {
+        MCPGNZ_PROFILE_OP(4, T, "scalar operator/");
         return vec4<T>{
             scalar / rhs.x,
                 scalar / rhs.y,
@@ -259,4 +285,22 @@ namespace mcpgnz
         };
     }
     #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
+
+namespace std
+{
+    template <typename T>
+    struct hash<mcpgnz::vec4<T>>
+    {
+        size_t operator()(const mcpgnz::vec4<T>& v) const
+        {
+            const hash<T> hasher;
+            size_t seed = hasher(v._x);
+            seed ^= hasher(v._y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hasher(v._z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hasher(v._w) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,447 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "vec3.h"
+
+namespace mcpgnz
+{
+    MCPGNZ_PROFILE_NAMESPACE_BEGIN
+    template <typename T>
+    struct weld_result
+    {
+        std::vector<vec3<T>> _positions;
+        std::vector<std::uint32_t> _remap;
+    };
+
+    #pragma region welding
+    /* merges near-equal positions (bit-exact equality for epsilon 0) and keeps the first vertex of
+       every group, _remap maps each input vertex into _positions; two vertices are near when all
+       their coordinates differ by at most epsilon and groups are the connected components of that
+       relation, so a chain of near vertices welds into one group whose extent along an axis may reach
+       (size - 1) * epsilon, only directly near pairs are guaranteed within epsilon of each other;
+       inputs of 0xFFFFFFFF vertices or more do not fit the remap table and yield an empty result */
+    template <typename T>
+    weld_result<T> weld(const vec3<T>* positions, std::size_t count, T epsilon = 0, unsigned threads = 0);
+    #pragma endregion
+
+    #pragma region implementation
+    namespace detail
+    {
+        constexpr std::uint32_t weld_empty = 0xFFFFFFFFu;
+        constexpr std::size_t weld_parallel_threshold = 1 << 16;
+
+        inline std::uint64_t weld_mix(std::uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /* runs body(thread, begin, end) over contiguous ranges of [0, count) on the given number of threads */
+        template <typename F>
+        void weld_parallel(const std::size_t count, const unsigned threads, F body)
+        {
+            if (threads == 1)
+            {
+                body(0u, std::size_t{ 0 }, count);
+                return;
+            }
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads);
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                workers.emplace_back(body, t, count * t / threads, count * (t + 1) / threads);
+            }
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        /* open addressing table over vertex indices, slots keep part of the hash to skip most key compares */
+        struct weld_table
+        {
+            struct slot
+            {
+                std::uint32_t _index;
+                std::uint32_t _tag;
+            };
+
+            std::vector<slot> _slots;
+            std::size_t _mask;
+
+            template <typename Key>
+            std::uint32_t find(const Key* keys, const Key& key, const std::uint64_t h) const
+            {
+                const std::uint32_t tag = static_cast<std::uint32_t>(h >> 32);
+                std::size_t index = static_cast<std::size_t>(h) & _mask;
+                while (true)
+                {
+                    const slot& s = _slots[index];
+                    if (s._index == weld_empty || (s._tag == tag && keys[s._index] == key))
+                    {
+                        return s._index;
+                    }
+                    index = (index + 1) & _mask;
+                }
+            }
+        };
+
+        template <typename Key>
+        void weld_partition(const Key* keys, const std::uint64_t* hashes, const std::uint32_t* indices, const std::size_t count,
+            std::uint32_t* representative, weld_table& table)
+        {
+            std::size_t capacity = 16;
+            while (capacity < 2 * count)
+            {
+                capacity <<= 1;
+            }
+            table._mask = capacity - 1;
+            table._slots.assign(capacity, weld_table::slot{ weld_empty, 0 });
+
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                const std::uint32_t i = indices[k];
+                const std::uint64_t h = hashes[i];
+                const std::uint32_t tag = static_cast<std::uint32_t>(h >> 32);
+                std::size_t index = static_cast<std::size_t>(h) & table._mask;
+                while (true)
+                {
+                    weld_table::slot& s = table._slots[index];
+                    if (s._index == weld_empty)
+                    {
+                        s = weld_table::slot{ i, tag };
+                        representative[i] = i;
+                        break;
+                    }
+                    if (s._tag == tag && keys[s._index] == keys[i])
+                    {
+                        representative[i] = s._index;
+                        break;
+                    }
+                    index = (index + 1) & table._mask;
+                }
+            }
+        }
+
+        /* std::hash of small integer cells is close to the identity and collides once combined */
+        struct weld_cell_hash
+        {
+            std::size_t operator()(const vec3<std::int64_t>& cell) const
+            {
+                const std::uint64_t h = static_cast<std::uint64_t>(cell._x) * 0x9E3779B97F4A7C15ull
+                    ^ static_cast<std::uint64_t>(cell._y) * 0xC2B2AE3D27D4EB4Full
+                    ^ static_cast<std::uint64_t>(cell._z) * 0x165667B19E3779F9ull;
+                return static_cast<std::size_t>(h ^ (h >> 29));
+            }
+        };
+
+        /* groups equal keys, each of the resulting tables owns a slice of the hash space; every worker walks
+           its vertices in input order, so the lowest index of every key becomes its representative
+           regardless of thread count */
+        template <typename Key, typename Hash = std::hash<Key>>
+        struct weld_groups
+        {
+            std::vector<std::uint32_t> _representative;
+            std::vector<weld_table> _tables;
+            Hash _hasher;
+
+            weld_groups(const Key* keys, const std::size_t count, const unsigned threads)
+                : _representative(count)
+                , _tables(threads)
+            {
+                /* every worker counts the slices of its range, the offsets are laid out slice major so
+                   the scatter keeps the indices of each slice in input order */
+                std::vector<std::uint64_t> hashes(count);
+                std::vector<std::size_t> offsets(std::size_t{ threads } * threads, 0);
+                weld_parallel(count, threads, [&](const unsigned thread, const std::size_t begin, const std::size_t end)
+                {
+                    std::size_t* counts = offsets.data() + std::size_t{ thread } * threads;
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        hashes[i] = hash(keys[i]);
+                        ++counts[slice(hashes[i])];
+                    }
+                });
+
+                std::vector<std::size_t> bounds(threads + 1);
+                std::size_t total = 0;
+                for (unsigned s = 0; s < threads; ++s)
+                {
+                    bounds[s] = total;
+                    for (unsigned thread = 0; thread < threads; ++thread)
+                    {
+                        const std::size_t size = offsets[std::size_t{ thread } * threads + s];
+                        offsets[std::size_t{ thread } * threads + s] = total;
+                        total += size;
+                    }
+                }
+                bounds[threads] = total;
+
+                std::vector<std::uint32_t> indices(count);
+                weld_parallel(count, threads, [&](const unsigned thread, const std::size_t begin, const std::size_t end)
+                {
+                    std::size_t* cursor = offsets.data() + std::size_t{ thread } * threads;
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        indices[cursor[slice(hashes[i])]++] = static_cast<std::uint32_t>(i);
+                    }
+                });
+
+                weld_parallel(threads, threads, [&](unsigned, const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t s = begin; s < end; ++s)
+                    {
+                        weld_partition(keys, hashes.data(), indices.data() + bounds[s], bounds[s + 1] - bounds[s],
+                            _representative.data(), _tables[s]);
+                    }
+                });
+            }
+
+            std::size_t slice(const std::uint64_t h) const
+            {
+                return static_cast<std::size_t>((h >> 32) % _tables.size());
+            }
+
+            std::uint64_t hash(const Key& key) const
+            {
+                return weld_mix(static_cast<std::uint64_t>(_hasher(key)));
+            }
+
+            /* first vertex carrying key, weld_empty when there is none */
+            std::uint32_t find(const Key* keys, const Key& key) const
+            {
+                const std::uint64_t h = hash(key);
+                return _tables[slice(h)].find(keys, key, h);
+            }
+        };
+
+        template <typename T>
+        bool weld_near(const vec3<T>& lhs, const vec3<T>& rhs, const T epsilon)
+        {
+            return std::abs(lhs._x - rhs._x) <= epsilon
+                && std::abs(lhs._y - rhs._y) <= epsilon
+                && std::abs(lhs._z - rhs._z) <= epsilon;
+        }
+
+        /* union find over vertex indices that may be joined from several threads at once; a root is
+           only ever linked below a smaller one, so every set ends up rooted at its lowest index
+           whatever order the joins happen in */
+        struct weld_sets
+        {
+            std::vector<std::atomic<std::uint32_t>> _parent;
+
+            explicit weld_sets(const std::size_t count) : _parent(count) {}
+
+            std::uint32_t find(std::uint32_t i)
+            {
+                while (true)
+                {
+                    std::uint32_t parent = _parent[i].load(std::memory_order_relaxed);
+                    if (parent == i)
+                    {
+                        return i;
+                    }
+                    const std::uint32_t grandparent = _parent[parent].load(std::memory_order_relaxed);
+                    if (grandparent != parent)
+                    {
+                        _parent[i].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+                    }
+                    i = grandparent;
+                }
+            }
+
+            void join(std::uint32_t a, std::uint32_t b)
+            {
+                while (true)
+                {
+                    a = find(a);
+                    b = find(b);
+                    if (a == b)
+                    {
+                        return;
+                    }
+                    if (a < b)
+                    {
+                        std::swap(a, b);
+                    }
+                    std::uint32_t expected = a;
+                    if (_parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                }
+            }
+        };
+    }
+
+    template <typename T>
+    weld_result<T> weld(const vec3<T>* positions, const std::size_t count, const T epsilon, unsigned threads)
+    {
+        MCPGNZ_PROFILE_BATCH(T, "weld", count);
+        weld_result<T> result;
+        if (count >= detail::weld_empty)
+        {
+            return result;
+        }
+
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (count < detail::weld_parallel_threshold)
+        {
+            threads = 1;
+        }
+
+        std::vector<std::uint32_t> representative;
+        if (epsilon > 0)
+        {
+            const T inv = 1 / epsilon;
+            std::vector<vec3<std::int64_t>> cells(count);
+            detail::weld_parallel(count, threads, [&](unsigned, const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    cells[i] = vec3<std::int64_t>{
+                        static_cast<std::int64_t>(std::floor(positions[i]._x * inv)),
+                        static_cast<std::int64_t>(std::floor(positions[i]._y * inv)),
+                        static_cast<std::int64_t>(std::floor(positions[i]._z * inv)) };
+                }
+            });
+
+            detail::weld_groups<vec3<std::int64_t>, detail::weld_cell_hash> groups{ cells.data(), count, threads };
+            const std::vector<std::uint32_t>& leader = groups._representative;
+
+            /* the vertices of every cell in input order, members[first[l], last[l]) for the first vertex l of the cell */
+            std::vector<std::uint32_t> first(count, 0);
+            std::vector<std::uint32_t> last(count);
+            std::vector<std::uint32_t> members(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ++first[leader[i]];
+            }
+            std::uint32_t total = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (leader[i] == i)
+                {
+                    const std::uint32_t size = first[i];
+                    first[i] = total;
+                    last[i] = total;
+                    total += size;
+                }
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                members[last[leader[i]]++] = static_cast<std::uint32_t>(i);
+            }
+
+            detail::weld_sets sets{ count };
+            detail::weld_parallel(count, threads, [&](unsigned, const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    sets._parent[i].store(static_cast<std::uint32_t>(i), std::memory_order_relaxed);
+                }
+            });
+
+            /* every cell joins its own near pairs and those it forms with the neighbouring cells of lower
+               leaders, so each pair of cells is compared once; vertices of one cell are near its first
+               vertex unless rounding put them on the edge, only those are compared with the whole cell */
+            detail::weld_parallel(count, threads, [&](unsigned, const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    const std::uint32_t l = static_cast<std::uint32_t>(i);
+                    if (leader[i] != l)
+                    {
+                        continue;
+                    }
+                    const std::uint32_t* own = members.data() + first[l];
+                    const std::uint32_t* own_end = members.data() + last[l];
+                    for (const std::uint32_t* a = own + 1; a < own_end; ++a)
+                    {
+                        if (detail::weld_near(positions[*a], positions[l], epsilon))
+                        {
+                            sets.join(*a, l);
+                            continue;
+                        }
+                        for (const std::uint32_t* b = own + 1; b < own_end; ++b)
+                        {
+                            if (b != a && detail::weld_near(positions[*a], positions[*b], epsilon))
+                            {
+                                sets.join(*a, *b);
+                            }
+                        }
+                    }
+
+                    for (int dz = -1; dz <= 1; ++dz)
+                    {
+                        for (int dy = -1; dy <= 1; ++dy)
+                        {
+                            for (int dx = -1; dx <= 1; ++dx)
+                            {
+                                const vec3<std::int64_t> cell{ cells[l]._x + dx, cells[l]._y + dy, cells[l]._z + dz };
+                                const std::uint32_t other = groups.find(cells.data(), cell);
+                                if (other >= l)
+                                {
+                                    continue;
+                                }
+                                for (const std::uint32_t* a = own; a < own_end; ++a)
+                                {
+                                    for (std::uint32_t k = first[other]; k < last[other]; ++k)
+                                    {
+                                        if (detail::weld_near(positions[*a], positions[members[k]], epsilon))
+                                        {
+                                            sets.join(*a, members[k]);
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+
+            representative.resize(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                representative[i] = sets.find(static_cast<std::uint32_t>(i));
+            }
+        }
+        else
+        {
+            representative = detail::weld_groups<vec3<T>>{ positions, count, threads }._representative;
+        }
+
+        /* representatives always precede the vertices merged into them */
+        result._remap.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (representative[i] == i)
+            {
+                result._remap[i] = static_cast<std::uint32_t>(result._positions.size());
+                result._positions.push_back(positions[i]);
+            }
+            else
+            {
+                result._remap[i] = result._remap[representative[i]];
+            }
+        }
+        return result;
+    }
+    #pragma endregion
+    MCPGNZ_PROFILE_NAMESPACE_END
+}
\ No newline at end of file